@@ -31,30 +31,12 @@ public:
 
         for (int j = 0; j < image_height; j++) {
             std::clog << "\rScanlines remaining: " << (image_height - j) << ' ' << std::flush;
-            for (int i = 0; i < image_width; i++) {
-                color pixel_color { 0.0, 0.0, 0.0 };
-                for (int sample = 0; sample < samples_per_pixel; sample++) {
-                    ray r = get_ray(i, j);
-                    pixel_color += ray_color(r, max_depth, world);
-                }
-                write_color(std::cout, pixel_samples_scale * pixel_color);
-            }
+            render_scanline(std::cout, j, world);
         }
 
         std::clog << "\rDone.                 \n";
     }
 
-private:
-    int image_height = 0; // rendered image height
-    double pixel_samples_scale; // color scale factor for a sum of pixel samples
-    point3 center; // camera center
-    point3 pixel00_loc; // location of pixel 0, 0
-    vec3 pixel_delta_u; // offset to pixel to the right
-    vec3 pixel_delta_v; // offset to pixel to the bottom
-    vec3 u, v, w; // camera frame basis vectors
-    vec3 defocus_disk_u; // defocus disk horizontal radius
-    vec3 defocus_disk_v; // defocus disk vertical radius
-
     auto initialize() -> void {
         // Calculate the image height, and ensure that it's at least 1
         image_height = static_cast<int>(image_width / aspect_ratio);
@@ -93,6 +75,36 @@ private:
         defocus_disk_v = v * defocus_radius;
     }
 
+    [[nodiscard]] auto height() const -> int { return image_height; }
+
+    auto render_scanline(std::ostream& out, int j, const hittable& world) const -> void {
+        // Writes row j of the image; only reads camera state, so rows may be rendered concurrently once initialized
+        for (int i = 0; i < image_width; i++) {
+            write_color(out, render_pixel(i, j, world));
+        }
+    }
+
+    [[nodiscard]] auto render_pixel(int i, int j, const hittable& world) const -> color {
+        // Returns the averaged color of all samples taken for pixel (i, j)
+        color pixel_color { 0.0, 0.0, 0.0 };
+        for (int sample = 0; sample < samples_per_pixel; sample++) {
+            ray r = get_ray(i, j);
+            pixel_color += ray_color(r, max_depth, world);
+        }
+        return pixel_samples_scale * pixel_color;
+    }
+
+private:
+    int image_height = 0; // rendered image height
+    double pixel_samples_scale; // color scale factor for a sum of pixel samples
+    point3 center; // camera center
+    point3 pixel00_loc; // location of pixel 0, 0
+    vec3 pixel_delta_u; // offset to pixel to the right
+    vec3 pixel_delta_v; // offset to pixel to the bottom
+    vec3 u, v, w; // camera frame basis vectors
+    vec3 defocus_disk_u; // defocus disk horizontal radius
+    vec3 defocus_disk_v; // defocus disk vertical radius
+
     [[nodiscard]] auto get_ray(int i, int j) const -> ray {
         // Construct a camera ray originating from the defocus disk and directed at randomly
         // sampled point around the pixel location (i, j)
@@ -116,7 +128,7 @@ private:
         return center + (p[0] * defocus_disk_u) + (p[1] * defocus_disk_v);
     }
 
-    auto ray_color(const ray& r, int depth, const hittable& world) -> color {
+    auto ray_color(const ray& r, int depth, const hittable& world) const -> color {
         // if we've exceeded the ray bounce limit, no more light is gathered
         if (depth <= 0)
             return color { 0.0, 0.0, 0.0 };
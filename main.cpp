@@ -4,50 +4,44 @@
 #include "hittable.h"
 #include "hittable_list.h"
 #include "material.h"
+#include "render_server.h"
+#include "scene.h"
 #include "sphere.h"
 
-auto main() -> int {
-    hittable_list world;
-
-    auto ground_material = std::make_shared<lambertian>(color { 0.5, 0.5, 0.5 });
-    world.add(std::make_shared<sphere>(point3 { 0.0, -1000.0, 0.0 }, 1000.0, ground_material));
-
-    for (int a = -11; a < 11; a++) {
-        for (int b = -11; b < 11; b++) {
-            auto choose_mat = random_double();
-            point3 center { a + 0.9 * random_double(), 0.2, b + 0.9 * random_double() };
-
-            if ((center - point3 { 4.0, 0.2, 0.0 }).length() > 0.9) {
-                std::shared_ptr<material> sphere_material;
-
-                if (choose_mat < 0.8) {
-                    // diffuse
-                    auto albedo = color::random() * color::random();
-                    sphere_material = std::make_shared<lambertian>(albedo);
-                    world.add(make_shared<sphere>(center, 0.2, sphere_material));
-                } else if (choose_mat < 0.95) {
-                    // metal
-                    auto albedo = color::random(0.5, 1);
-                    auto fuzz = random_double(0.0, 0.5);
-                    sphere_material = std::make_shared<metal>(albedo, fuzz);
-                    world.add(make_shared<sphere>(center, 0.2, sphere_material));
-                } else {
-                    // glass
-                    sphere_material = std::make_shared<dielectric>(1.5);
-                    world.add(make_shared<sphere>(center, 0.2, sphere_material));
-                }
+#include <charconv>
+#include <string_view>
+#include <thread>
+
+auto main(int argc, char* argv[]) -> int {
+    // `raytracer --serve <socket path> [--threads <count>]` keeps running and renders jobs sent over the socket
+    if (argc >= 2 && std::string_view { argv[1] } == "--serve") {
+        const auto usage = [argv] {
+            std::clog << "usage: " << argv[0] << " --serve <socket path> [--threads <count>]\n";
+            return 2;
+        };
+
+        if (argc != 3 && argc != 5)
+            return usage();
+
+        unsigned thread_count = std::thread::hardware_concurrency();
+        if (argc == 5) {
+            if (std::string_view { argv[3] } != "--threads")
+                return usage();
+
+            const std::string_view count { argv[4] };
+            const auto [end, error] = std::from_chars(count.data(), count.data() + count.size(), thread_count);
+            if (error != std::errc {} || end != count.data() + count.size() || thread_count < 1
+                || thread_count > 1024) {
+                std::clog << "invalid thread count '" << count << "'\n";
+                return usage();
             }
         }
-    }
-
-    auto material1 = std::make_shared<dielectric>(1.5);
-    world.add(std::make_shared<sphere>(point3 { 0.0, 1.0, 0.0 }, 1.0, material1));
 
-    auto material2 = std::make_shared<lambertian>(color { 0.4, 0.2, 0.1 });
-    world.add(std::make_shared<sphere>(point3 { -4.0, 1.0, 0.0 }, 1.0, material2));
+        render_server server { thread_count };
+        return server.serve(argv[2]) ? 0 : 1;
+    }
 
-    auto material3 = std::make_shared<metal>(color { 0.7, 0.6, 0.5 }, 0.0);
-    world.add(std::make_shared<sphere>(point3 { 4.0, 1.0, 0.0 }, 1.0, material3));
+    hittable_list world = random_spheres_scene();
 
     camera camera;
 
@@ -0,0 +1,555 @@
+//
+// Created by Jun Kai Gan on 19/10/2026.
+//
+
+#pragma once
+
+#include "rtweekend.h"
+
+#include "camera.h"
+#include "hittable_list.h"
+#include "scene.h"
+#include "thread_pool.h"
+
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// A render job as sent by a client, one job per line of `key=value` fields:
+//
+//   render scene=random_spheres seed=5489 priority=0 width=400 aspect=1.7778 spp=10 depth=10 vfov=20
+//          from=13,2,3 at=0,0,0 up=0,1,0 defocus=0.6 focus=10
+//
+// Omitted fields keep their defaults. The server answers with `scene <key> built|cached` and `image <width> <height>`,
+// then streams `progress <rows done> <rows total>` lines interleaved with `scanline <row> <byte count>` lines, each
+// followed by that many bytes of PPM pixel data. Rows are sent top to bottom as soon as all rows above them are done,
+// and a final `done` line ends the image. A job that cannot be rendered gets an `error <message>` line instead, at any
+// point of the reply.
+class render_job {
+public:
+    static constexpr int max_image_size = 8192; // largest accepted image width or height in pixels
+    static constexpr int max_samples_per_pixel = 10000;
+    static constexpr int max_ray_depth = 1000;
+
+    std::string scene = "random_spheres"; // name of a scene known to build_scene()
+    std::uint32_t seed = std::mt19937::default_seed; // seed for building the scene and sampling it
+    int priority = 0; // jobs with a higher priority get their scanlines rendered first
+    camera view; // camera and quality settings for this job
+
+    [[nodiscard]] auto scene_key() const -> std::string {
+        // Everything that determines the scene's content, so equal keys can share one loaded world
+        return scene + ':' + std::to_string(seed);
+    }
+
+    [[nodiscard]] auto scanline_seed(int j) const -> std::uint32_t {
+        // Gives every row its own sample sequence, independent of which worker renders it or when
+        std::seed_seq sequence { seed, static_cast<std::uint32_t>(j) };
+        std::uint32_t scanline;
+        sequence.generate(&scanline, &scanline + 1);
+        return scanline;
+    }
+
+    auto parse(const std::string& line, std::string& error) -> bool {
+        std::istringstream fields { line };
+        std::string field;
+
+        if (!(fields >> field) || field != "render") {
+            error = "expected 'render'";
+            return false;
+        }
+
+        while (fields >> field) {
+            const auto separator = field.find('=');
+            if (separator == std::string::npos) {
+                error = "malformed field '" + field + "'";
+                return false;
+            }
+
+            const auto key = field.substr(0, separator);
+            const auto value = field.substr(separator + 1);
+            bool ok;
+
+            if (key == "scene") {
+                scene = value;
+                ok = !scene.empty();
+            } else if (key == "seed")
+                ok = parse_seed(value, seed);
+            else if (key == "priority")
+                ok = parse_value(value, priority);
+            else if (key == "width")
+                ok = parse_value(value, view.image_width) && view.image_width > 0
+                    && view.image_width <= max_image_size;
+            else if (key == "aspect")
+                ok = parse_value(value, view.aspect_ratio) && view.aspect_ratio > 0.0;
+            else if (key == "spp")
+                ok = parse_value(value, view.samples_per_pixel) && view.samples_per_pixel > 0
+                    && view.samples_per_pixel <= max_samples_per_pixel;
+            else if (key == "depth")
+                ok = parse_value(value, view.max_depth) && view.max_depth > 0 && view.max_depth <= max_ray_depth;
+            else if (key == "vfov")
+                ok = parse_value(value, view.vfov) && view.vfov > 0.0 && view.vfov < 180.0;
+            else if (key == "from")
+                ok = parse_vec3(value, view.look_from);
+            else if (key == "at")
+                ok = parse_vec3(value, view.look_at);
+            else if (key == "up")
+                ok = parse_vec3(value, view.vup);
+            else if (key == "defocus")
+                ok = parse_value(value, view.defocus_angle) && view.defocus_angle >= 0.0 && view.defocus_angle < 180.0;
+            else if (key == "focus")
+                ok = parse_value(value, view.focus_distance) && view.focus_distance > 0.0;
+            else {
+                error = "unknown field '" + key + "'";
+                return false;
+            }
+
+            if (!ok) {
+                error = "invalid value for '" + key + "'";
+                return false;
+            }
+        }
+
+        return validate(error);
+    }
+
+private:
+    [[nodiscard]] auto validate(std::string& error) const -> bool {
+        // Checks the settings that only make sense together; done in double so huge values cannot overflow an int
+        const auto image_height = view.image_width / view.aspect_ratio;
+        if (image_height > max_image_size) {
+            error = "image height exceeds " + std::to_string(max_image_size);
+            return false;
+        }
+
+        const auto view_direction = view.look_from - view.look_at;
+        if (view_direction.near_zero()) {
+            error = "'from' and 'at' must differ";
+            return false;
+        }
+        if (cross(view.vup, unit_vector(view_direction)).near_zero()) {
+            error = "'up' must not be parallel to the view direction";
+            return false;
+        }
+
+        return true;
+    }
+
+    template<typename T>
+    static auto parse_value(const std::string& text, T& value) -> bool {
+        std::istringstream in { text };
+        T parsed;
+        if (!(in >> parsed) || !in.eof())
+            return false;
+        value = parsed;
+        return true;
+    }
+
+    static auto parse_seed(const std::string& text, std::uint32_t& value) -> bool {
+        // The generators only use 32 bits of a seed, so anything negative or wider is rejected rather than letting
+        // two spellings of one seed build separate cache entries
+        const auto end = text.data() + text.size();
+        const auto [parsed_end, error] = std::from_chars(text.data(), end, value);
+        return error == std::errc {} && parsed_end == end;
+    }
+
+    static auto parse_vec3(const std::string& text, vec3& value) -> bool {
+        std::istringstream in { text };
+        double x, y, z;
+        char comma1, comma2;
+        if (!(in >> x >> comma1 >> y >> comma2 >> z) || comma1 != ',' || comma2 != ',' || !in.eof())
+            return false;
+        value = vec3 { x, y, z };
+        return true;
+    }
+};
+
+class scene_cache {
+public:
+    static constexpr std::size_t default_capacity = 8; // loaded worlds kept alive between jobs
+
+    explicit scene_cache(std::size_t capacity = default_capacity)
+        : capacity(capacity < 1 ? 1 : capacity) { }
+
+    auto get(const render_job& job, bool& built_now) -> std::shared_ptr<const hittable_list> {
+        // Returns the loaded world for the job's scene, building it on first use. Concurrent requests for a scene
+        // that is still being built wait for that build instead of starting their own. Only the most recently
+        // used scenes stay cached; an evicted world lives on until the jobs still rendering it finish.
+        const auto key = job.scene_key();
+        built_now = false;
+        std::promise<std::shared_ptr<const hittable_list>> built;
+        std::shared_future<std::shared_ptr<const hittable_list>> pending;
+        std::uint64_t id = 0;
+        {
+            std::lock_guard lock { mutex };
+            auto found = scenes.find(key);
+            if (found != scenes.end()) {
+                recent.splice(recent.begin(), recent, found->second.position);
+                pending = found->second.world;
+            } else {
+                id = next_id++;
+                recent.push_front(key);
+                scenes.emplace(key, entry { built.get_future().share(), recent.begin(), id });
+                evict();
+            }
+        }
+
+        // wait outside the lock, the build may take a while
+        if (pending.valid())
+            return pending.get();
+
+        std::shared_ptr<hittable_list> world;
+        try {
+            world = std::make_shared<hittable_list>();
+            if (!build_scene(job.scene, job.seed, *world))
+                world = nullptr;
+        } catch (...) {
+            forget(key, id);
+            built.set_exception(std::current_exception());
+            throw;
+        }
+
+        // unknown scenes are not cached, so the map only ever holds real worlds
+        if (!world)
+            forget(key, id);
+        built_now = world != nullptr;
+        built.set_value(world);
+        return world;
+    }
+
+private:
+    struct entry {
+        std::shared_future<std::shared_ptr<const hittable_list>> world;
+        std::list<std::string>::iterator position; // place in `recent`
+        std::uint64_t id; // tells a rebuilt entry apart from an evicted one with the same key
+    };
+
+    std::size_t capacity;
+    std::uint64_t next_id = 0;
+    std::mutex mutex;
+    std::unordered_map<std::string, entry> scenes;
+    std::list<std::string> recent; // scene keys, most recently used first
+
+    auto evict() -> void {
+        while (scenes.size() > capacity) {
+            scenes.erase(recent.back());
+            recent.pop_back();
+        }
+    }
+
+    auto forget(const std::string& key, std::uint64_t id) -> void {
+        std::lock_guard lock { mutex };
+        auto found = scenes.find(key);
+        if (found != scenes.end() && found->second.id == id) {
+            recent.erase(found->second.position);
+            scenes.erase(found);
+        }
+    }
+};
+
+class render_server {
+public:
+    explicit render_server(unsigned thread_count)
+        : pool(thread_count) { }
+
+    auto serve(const std::string& socket_path) -> bool {
+        // Accepts connections on a Unix domain socket until the process is stopped or accepting fails for good.
+        // Only returns once every connection thread has finished, since they use the pool and the scene cache.
+        sockaddr_un address {};
+        if (socket_path.size() >= sizeof(address.sun_path)) {
+            std::clog << "Socket path is too long: " << socket_path << '\n';
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+        // a stale socket from an earlier run may be replaced, but never any other kind of file
+        struct stat existing {};
+        if (::lstat(socket_path.c_str(), &existing) == 0) {
+            if (!S_ISSOCK(existing.st_mode)) {
+                std::clog << "Refusing to replace " << socket_path << ": it exists and is not a socket\n";
+                return false;
+            }
+            ::unlink(socket_path.c_str());
+        }
+
+        const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) {
+            std::clog << "socket: " << std::strerror(errno) << '\n';
+            return false;
+        }
+
+        if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0
+            || ::listen(listener, SOMAXCONN) < 0) {
+            std::clog << "bind/listen " << socket_path << ": " << std::strerror(errno) << '\n';
+            ::close(listener);
+            return false;
+        }
+
+        // a client hanging up mid-job should fail the write, not kill the server
+        std::signal(SIGPIPE, SIG_IGN);
+        std::clog << "Listening on " << socket_path << '\n';
+
+        while (true) {
+            const int client = ::accept(listener, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR || errno == ECONNABORTED || errno == EPROTO)
+                    continue;
+                if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                    // out of descriptors or memory: give running jobs a moment to release some, then retry
+                    std::clog << "accept: " << std::strerror(errno) << ", retrying\n";
+                    std::this_thread::sleep_for(accept_retry_delay);
+                    continue;
+                }
+                std::clog << "accept: " << std::strerror(errno) << '\n';
+                break;
+            }
+
+            {
+                std::lock_guard lock { connections_mutex };
+                connections.insert(client);
+            }
+            try {
+                std::thread([this, client] { handle_connection(client); }).detach();
+            } catch (const std::system_error& e) {
+                std::clog << "Could not start a connection thread: " << e.what() << '\n';
+                finish_connection(client);
+            }
+        }
+
+        ::close(listener);
+        close_connections();
+        return false;
+    }
+
+private:
+    static constexpr std::size_t max_line_length = 4096; // longest accepted request line in bytes
+    static constexpr std::chrono::milliseconds hangup_poll_interval { 100 };
+    static constexpr std::chrono::milliseconds accept_retry_delay { 100 };
+
+    thread_pool pool;
+    scene_cache scenes;
+
+    std::mutex connections_mutex;
+    std::condition_variable connections_closed;
+    std::unordered_set<int> connections; // client sockets whose connection thread is still running
+
+    auto finish_connection(int client) -> void {
+        // Closed under the lock so close_connections() never shuts down a descriptor number that was reused
+        std::lock_guard lock { connections_mutex };
+        connections.erase(client);
+        ::close(client);
+        connections_closed.notify_all();
+    }
+
+    auto close_connections() -> void {
+        // Shutting the sockets down wakes threads blocked in read() and makes running jobs see a hangup
+        std::unique_lock lock { connections_mutex };
+        for (const int client: connections) {
+            ::shutdown(client, SHUT_RDWR);
+        }
+        connections_closed.wait(lock, [this] { return connections.empty(); });
+    }
+
+    auto handle_connection(int client) -> void {
+        // runs on a detached thread, so nothing may escape it: an uncaught exception would stop every client's job
+        try {
+            std::string pending;
+            std::string line;
+
+            while (read_line(client, pending, line)) {
+                if (line.empty())
+                    continue;
+
+                render_job job;
+                std::string error;
+                if (!job.parse(line, error)) {
+                    if (!write_all(client, "error " + error + "\n"))
+                        break;
+                    continue;
+                }
+
+                if (!run_job(client, job))
+                    break;
+            }
+        } catch (const std::exception& e) {
+            write_all(client, std::string { "error " } + e.what() + "\n");
+        } catch (...) {
+            write_all(client, "error internal failure\n");
+        }
+
+        finish_connection(client);
+    }
+
+    auto run_job(int client, render_job& job) -> bool {
+        // Splits the image into scanline tasks on the shared pool and streams progress and finished rows while they
+        // complete. Returns false once the client can no longer be written to.
+        bool built_now;
+        const auto world = scenes.get(job, built_now);
+        if (!world)
+            return write_all(client, "error unknown scene '" + job.scene + "'\n");
+        if (!write_all(client, "scene " + job.scene_key() + (built_now ? " built\n" : " cached\n")))
+            return false;
+
+        job.view.initialize();
+        const int rows = job.view.height();
+        if (!write_all(client, "image " + std::to_string(job.view.image_width) + " " + std::to_string(rows) + "\n"))
+            return false;
+
+        // the tasks share ownership of the job state, so it stays valid even if this thread unwinds early
+        struct progress {
+            render_job job;
+            std::shared_ptr<const hittable_list> world;
+            std::mutex mutex;
+            std::condition_variable changed;
+            std::vector<std::string> scanlines; // finished rows not yet sent
+            std::vector<bool> rendered;
+            int done = 0;
+            bool failed = false;
+            std::atomic<bool> abandoned = false;
+        };
+        auto state = std::make_shared<progress>();
+        state->job = job;
+        state->world = world;
+        state->scanlines.resize(rows);
+        state->rendered.resize(rows);
+
+        for (int j = 0; j < rows; j++) {
+            pool.submit(job.priority, [state, j] {
+                std::string scanline;
+                bool failed = false;
+                try {
+                    std::ostringstream out;
+                    seed_random(state->job.scanline_seed(j));
+                    for (int i = 0; i < state->job.view.image_width && !state->abandoned; i++) {
+                        write_color(out, state->job.view.render_pixel(i, j, *state->world));
+                    }
+                    scanline = out.str();
+                } catch (...) {
+                    failed = true;
+                }
+
+                std::lock_guard lock { state->mutex };
+                state->scanlines[j] = std::move(scanline);
+                state->rendered[j] = true;
+                state->failed = state->failed || failed;
+                state->done++;
+                state->changed.notify_one();
+            });
+        }
+
+        // a dead client's job is dropped as soon as the hangup is seen: running rows stop at the next pixel and
+        // queued rows are skipped, so they no longer hold up other jobs. Rows finished ahead of the next one to send
+        // wait in `scanlines` and are released as soon as they have been written.
+        int reported = 0;
+        int sent = 0;
+        while (sent < rows) {
+            bool changed;
+            bool failed;
+            std::vector<std::string> ready;
+            {
+                std::unique_lock lock { state->mutex };
+                changed = state->changed.wait_for(lock, hangup_poll_interval, [&] { return state->done > reported; });
+                reported = state->done;
+                failed = state->failed;
+                for (int j = sent; j < rows && state->rendered[j]; j++) {
+                    ready.push_back(std::move(state->scanlines[j]));
+                }
+            }
+
+            if (hung_up(client)) {
+                state->abandoned = true;
+                return false;
+            }
+
+            if (failed) {
+                state->abandoned = true;
+                return write_all(client, "error render failed\n");
+            }
+
+            const auto line = "progress " + std::to_string(reported) + " " + std::to_string(rows) + "\n";
+            if (changed && !write_all(client, line)) {
+                state->abandoned = true;
+                return false;
+            }
+
+            for (const auto& scanline: ready) {
+                const auto header = "scanline " + std::to_string(sent) + " " + std::to_string(scanline.size()) + "\n";
+                if (!write_all(client, header) || !write_all(client, scanline)) {
+                    state->abandoned = true;
+                    return false;
+                }
+                sent++;
+            }
+        }
+
+        return write_all(client, "done\n");
+    }
+
+    static auto hung_up(int client) -> bool {
+        // Checks without blocking whether the connection is gone. Reaching the end of the client's input is not a
+        // hangup: a client that shuts down its write side after sending a request still waits for the result.
+        pollfd descriptor { client, 0, 0 };
+        return ::poll(&descriptor, 1, 0) > 0 && (descriptor.revents & (POLLHUP | POLLERR | POLLNVAL));
+    }
+
+    static auto read_line(int client, std::string& pending, std::string& line) -> bool {
+        // Reads the next request line; a client that sends more than max_line_length bytes without one is dropped
+        while (true) {
+            const auto newline = pending.find('\n');
+            if (newline != std::string::npos) {
+                line = pending.substr(0, newline);
+                pending.erase(0, newline + 1);
+                if (!line.empty() && line.back() == '\r')
+                    line.pop_back();
+                return true;
+            }
+
+            char buffer[4096];
+            const auto count = ::read(client, buffer, sizeof(buffer));
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count <= 0)
+                return false;
+            pending.append(buffer, count);
+
+            if (pending.find('\n') == std::string::npos && pending.size() > max_line_length) {
+                write_all(client, "error request line exceeds " + std::to_string(max_line_length) + " bytes\n");
+                return false;
+            }
+        }
+    }
+
+    static auto write_all(int client, const std::string& data) -> bool {
+        std::size_t written = 0;
+        while (written < data.size()) {
+            const auto count = ::write(client, data.data() + written, data.size() - written);
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count <= 0)
+                return false;
+            written += count;
+        }
+        return true;
+    }
+};
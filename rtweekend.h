@@ -16,10 +16,15 @@ const double PI = 3.1415926535897932385;
 
 // Utility functions
 inline auto degrees_to_radians(double degrees) -> double { return degrees * PI / 180.0; }
+inline auto random_generator() -> std::mt19937& {
+    // each thread owns its generator so render workers can sample concurrently
+    thread_local std::mt19937 generator;
+    return generator;
+}
+inline auto seed_random(std::mt19937::result_type seed) -> void { random_generator().seed(seed); }
 inline auto random_double() -> double {
-    static std::uniform_real_distribution<double> distribution(0.0, 1.0);
-    static std::mt19937 generator;
-    return distribution(generator);
+    thread_local std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    return distribution(random_generator());
 }
 inline auto random_double(double min, double max) -> double { return min + (max - min) * random_double(); }
 
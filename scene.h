@@ -0,0 +1,71 @@
+//
+// Created by Jun Kai Gan on 19/10/2026.
+//
+
+#pragma once
+
+#include "rtweekend.h"
+
+#include "hittable_list.h"
+#include "material.h"
+#include "sphere.h"
+
+#include <string>
+
+inline auto random_spheres_scene() -> hittable_list {
+    hittable_list world;
+
+    auto ground_material = std::make_shared<lambertian>(color { 0.5, 0.5, 0.5 });
+    world.add(std::make_shared<sphere>(point3 { 0.0, -1000.0, 0.0 }, 1000.0, ground_material));
+
+    for (int a = -11; a < 11; a++) {
+        for (int b = -11; b < 11; b++) {
+            auto choose_mat = random_double();
+            point3 center { a + 0.9 * random_double(), 0.2, b + 0.9 * random_double() };
+
+            if ((center - point3 { 4.0, 0.2, 0.0 }).length() > 0.9) {
+                std::shared_ptr<material> sphere_material;
+
+                if (choose_mat < 0.8) {
+                    // diffuse
+                    auto albedo = color::random() * color::random();
+                    sphere_material = std::make_shared<lambertian>(albedo);
+                    world.add(make_shared<sphere>(center, 0.2, sphere_material));
+                } else if (choose_mat < 0.95) {
+                    // metal
+                    auto albedo = color::random(0.5, 1);
+                    auto fuzz = random_double(0.0, 0.5);
+                    sphere_material = std::make_shared<metal>(albedo, fuzz);
+                    world.add(make_shared<sphere>(center, 0.2, sphere_material));
+                } else {
+                    // glass
+                    sphere_material = std::make_shared<dielectric>(1.5);
+                    world.add(make_shared<sphere>(center, 0.2, sphere_material));
+                }
+            }
+        }
+    }
+
+    auto material1 = std::make_shared<dielectric>(1.5);
+    world.add(std::make_shared<sphere>(point3 { 0.0, 1.0, 0.0 }, 1.0, material1));
+
+    auto material2 = std::make_shared<lambertian>(color { 0.4, 0.2, 0.1 });
+    world.add(std::make_shared<sphere>(point3 { -4.0, 1.0, 0.0 }, 1.0, material2));
+
+    auto material3 = std::make_shared<metal>(color { 0.7, 0.6, 0.5 }, 0.0);
+    world.add(std::make_shared<sphere>(point3 { 4.0, 1.0, 0.0 }, 1.0, material3));
+
+    return world;
+}
+
+inline auto build_scene(const std::string& name, std::mt19937::result_type seed, hittable_list& world) -> bool {
+    // Builds the named scene on the calling thread; the same name and seed always produce the same world
+    seed_random(seed);
+
+    if (name == "random_spheres") {
+        world = random_spheres_scene();
+        return true;
+    }
+
+    return false;
+}
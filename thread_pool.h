@@ -0,0 +1,83 @@
+//
+// Created by Jun Kai Gan on 19/10/2026.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class thread_pool {
+public:
+    explicit thread_pool(unsigned thread_count) {
+        thread_count = (thread_count < 1) ? 1 : thread_count;
+        for (unsigned i = 0; i < thread_count; i++) {
+            workers.emplace_back([this] { work(); });
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    auto operator=(const thread_pool&) -> thread_pool& = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard lock { mutex };
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker: workers) {
+            worker.join();
+        }
+    }
+
+    auto submit(int priority, std::function<void()> task) -> void {
+        // Higher priority tasks run first; tasks of equal priority run in submission order
+        {
+            std::lock_guard lock { mutex };
+            tasks.push(entry { priority, next_sequence++, std::move(task) });
+        }
+        wake.notify_one();
+    }
+
+private:
+    struct entry {
+        int priority;
+        std::uint64_t sequence;
+        std::function<void()> task;
+    };
+
+    struct runs_later {
+        auto operator()(const entry& a, const entry& b) const -> bool {
+            if (a.priority != b.priority)
+                return a.priority < b.priority;
+            return a.sequence > b.sequence;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    std::priority_queue<entry, std::vector<entry>, runs_later> tasks;
+    std::uint64_t next_sequence = 0;
+    bool stopping = false;
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    auto work() -> void {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock { mutex };
+                wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (tasks.empty())
+                    return;
+                task = tasks.top().task;
+                tasks.pop();
+            }
+            task();
+        }
+    }
+};
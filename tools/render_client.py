@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Sends render jobs to a `raytracer --serve` instance.
+
+usage: render_client.py <socket path> [key=value ...] > image.ppm
+
+The fields are the ones accepted by the server, e.g. `width=400 spp=10 from=13,2,3`. Progress goes to stderr and the
+PPM image to stdout, written row by row as the server streams it.
+"""
+
+import socket
+import sys
+
+
+class RenderError(Exception):
+    pass
+
+
+class RenderClient:
+    def __init__(self, socket_path):
+        self.socket = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.socket.connect(socket_path)
+        self.reader = self.socket.makefile("rb")
+
+    def close(self):
+        self.reader.close()
+        self.socket.close()
+
+    def send_line(self, line):
+        self.socket.sendall(line.encode() + b"\n")
+
+    def render(self, fields, on_progress=None, output=None):
+        """Renders one job and returns (scene status, PPM bytes); raises RenderError on an `error` reply.
+
+        With an `output` file the image is written there as it streams in and None is returned in its place.
+        """
+        self.send_line(" ".join(["render"] + list(fields)))
+        return self.read_reply(on_progress, output)
+
+    def read_reply(self, on_progress=None, output=None):
+        status = None
+        parts = []
+        write = output.write if output else parts.append
+        rows = 0
+        while True:
+            line = self.reader.readline().decode()
+            if not line:
+                raise RenderError("connection closed by server")
+
+            kind, _, rest = line.rstrip("\n").partition(" ")
+            if kind == "error":
+                raise RenderError(rest)
+            if kind == "scene":
+                status = rest.split()[-1]
+            elif kind == "progress":
+                if on_progress:
+                    done, total = rest.split()
+                    on_progress(int(done), int(total))
+            elif kind == "image":
+                width, height = rest.split()
+                write(f"P3\n{width} {height}\n255\n".encode())
+            elif kind == "scanline":
+                row, size = (int(value) for value in rest.split())
+                if row != rows:
+                    raise RenderError(f"expected scanline {rows}, got {row}")
+                write(self.reader.read(size))
+                rows += 1
+            elif kind == "done":
+                return status, None if output else b"".join(parts)
+            else:
+                raise RenderError("unexpected reply: " + line)
+
+
+def main(argv):
+    if len(argv) < 2:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+
+    def report(done, total):
+        print(f"\rScanlines done: {done}/{total} ", end="", file=sys.stderr, flush=True)
+
+    client = RenderClient(argv[1])
+    try:
+        status, _ = client.render(argv[2:], report, sys.stdout.buffer)
+    except RenderError as e:
+        print(f"error: {e}", file=sys.stderr)
+        return 1
+    finally:
+        client.close()
+
+    print(f"\rDone, scene {status}.          ", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
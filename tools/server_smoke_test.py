@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""Starts `raytracer --serve` and checks the job protocol end to end.
+
+usage: server_smoke_test.py <path to raytracer>
+"""
+
+import os
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+
+from render_client import RenderClient, RenderError
+
+SMALL_JOB = ["width=40", "aspect=2", "spp=2", "depth=5", "seed=7"]
+
+
+def check(condition, message):
+    if not condition:
+        raise AssertionError(message)
+
+
+def expect_error(client, line):
+    client.send_line(line)
+    try:
+        client.read_reply()
+    except RenderError:
+        return
+    raise AssertionError(f"expected an error for: {line}")
+
+
+def check_image(image, width, height):
+    header = image.split(b"\n", 3)
+    check(header[:3] == [b"P3", f"{width} {height}".encode(), b"255"], f"bad PPM header: {header[:3]}")
+    check(len(header[3].split()) == width * height * 3, "PPM has the wrong number of color components")
+
+
+def run(raytracer, socket_path):
+    server = subprocess.Popen([raytracer, "--serve", socket_path, "--threads", "2"], stderr=subprocess.DEVNULL)
+    try:
+        for _ in range(100):
+            if os.path.exists(socket_path):
+                break
+            time.sleep(0.05)
+        check(os.path.exists(socket_path), "server did not create its socket")
+
+        client = RenderClient(socket_path)
+        try:
+            # two camera views of one scene: the second reuses the loaded world
+            status, front = client.render(SMALL_JOB + ["from=13,2,3"])
+            check(status == "built", f"first view should build the scene, got {status}")
+            check_image(front, 40, 20)
+
+            status, side = client.render(SMALL_JOB + ["from=3,2,13"])
+            check(status == "cached", f"second view should reuse the scene, got {status}")
+            check_image(side, 40, 20)
+            check(front != side, "different views rendered the same image")
+
+            # sampling is seeded per scanline, so a job renders the same image however it is scheduled
+            _, again = client.render(SMALL_JOB + ["from=13,2,3"])
+            check(again == front, "the same job rendered a different image")
+
+            expect_error(client, "bogus")
+            expect_error(client, "render width=abc")
+            expect_error(client, "render spp")
+            expect_error(client, "render scene=missing")
+            expect_error(client, "render from=1,1,1 at=1,1,1")
+            expect_error(client, "render width=2000000000 aspect=0.001 spp=1")
+            expect_error(client, "render width=100 aspect=0.001")
+            expect_error(client, "render spp=1000000")
+            expect_error(client, "render seed=-1")
+            expect_error(client, "render seed=4294967303")
+
+            # the connection is still usable after errors
+            status, _ = client.render(SMALL_JOB)
+            check(status == "cached", f"scene should still be cached, got {status}")
+        finally:
+            client.close()
+
+        # a client that half-closes after sending its request still gets the image
+        client = RenderClient(socket_path)
+        try:
+            client.send_line(" ".join(["render"] + SMALL_JOB))
+            client.socket.shutdown(socket.SHUT_WR)
+            status, image = client.read_reply()
+            check(status == "cached", f"half-closed client should reuse the scene, got {status}")
+            check_image(image, 40, 20)
+        finally:
+            client.close()
+
+        # an unterminated oversized line is rejected and the connection closed
+        client = RenderClient(socket_path)
+        try:
+            client.socket.sendall(b"x" * 10000)
+            try:
+                client.read_reply()
+                raise AssertionError("expected an error for an oversized request line")
+            except RenderError as e:
+                check("exceeds" in str(e), f"unexpected error for an oversized line: {e}")
+        finally:
+            client.close()
+
+        check(server.poll() is None, "server exited during the test")
+    finally:
+        server.terminate()
+        server.wait()
+
+
+def main(argv):
+    if len(argv) != 2:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+
+    with tempfile.TemporaryDirectory() as directory:
+        try:
+            run(os.path.abspath(argv[1]), os.path.join(directory, "raytracer.sock"))
+        except (AssertionError, RenderError, OSError) as e:
+            print(f"FAILED: {e}", file=sys.stderr)
+            return 1
+
+    print("server smoke test passed")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))